@@ -0,0 +1,375 @@
+#pragma once
+#include <SFML/Config.hpp>
+#include <vector>
+#include <cmath>
+#include <algorithm>
+#include <cstddef>
+
+// Streaming loudness meter following EBU R128 / ITU-R BS.1770.
+//
+// Samples are fed incrementally (interleaved 16-bit frames) and the meter
+// keeps:
+//   - momentary loudness (400 ms window)
+//   - short-term loudness (3 s window)
+//   - integrated loudness (whole stream, absolute -70 LUFS and relative -10 LU gates)
+//   - true peak (4x oversampled)
+//
+// Work is done once per sample, so the whole track can be metered while it
+// plays instead of measuring a sampled window every frame.
+//
+// Channel weights follow BS.1770 for the layouts SFML decodes: mono, stereo,
+// quad (FL FR RL RR), 5.1 (FL FR FC LFE RL RR), 6.1 and 7.1. The LFE channel
+// is excluded and surround channels are weighted 1.41. Other channel counts
+// use 1.0 for every channel.
+class LoudnessMeter {
+public:
+    static constexpr float LOUDNESS_FLOOR = -70.0f;  // Absolute gate, also reported for silence
+
+    LoudnessMeter(unsigned int sampleRate = 44100, unsigned int channels = 2) {
+        configure(sampleRate, channels);
+    }
+
+    // Change the stream format (also resets the meter)
+    void configure(unsigned int sampleRate, unsigned int channels) {
+        m_sampleRate = std::max(1u, sampleRate);
+        m_channels = std::max(1u, channels);
+        m_subblockFrames = std::max<size_t>(1, m_sampleRate / 10);  // 100 ms
+
+        designKWeighting();
+        designTruePeakFilter();
+
+        m_channelWeights.resize(m_channels);
+        m_channelWeightSum = 0.0f;
+        for (unsigned int c = 0; c < m_channels; c++) {
+            m_channelWeights[c] = channelWeight(c, m_channels);
+            m_channelWeightSum += m_channelWeights[c];
+        }
+
+        m_channelState.assign(m_channels, ChannelState());
+        m_channelBuffer.resize(TRUE_PEAK_HISTORY + m_subblockFrames);
+        m_phaseOutput.resize(m_subblockFrames);
+        reset();
+    }
+
+    // Clear all measurements (call after seeking or restarting playback)
+    void reset() {
+        for (auto& state : m_channelState) {
+            state = ChannelState();
+        }
+        m_subblockPos = 0;
+        m_subblockEnergy.clear();
+        m_histogramCount.assign(HISTOGRAM_BINS, 0);
+        m_histogramEnergy.assign(HISTOGRAM_BINS, 0.0);
+        m_gatingBlockCount = 0;
+        m_truePeak = 0.0f;
+    }
+
+    // Feed interleaved frames
+    void process(const sf::Int16* samples, size_t frameCount) {
+        while (frameCount > 0) {
+            size_t count = std::min(frameCount, m_subblockFrames - m_subblockPos);
+
+            for (unsigned int c = 0; c < m_channels; c++) {
+                processChannel(m_channelState[c], m_channelWeights[c], samples + c, count);
+            }
+
+            samples += count * m_channels;
+            frameCount -= count;
+            m_subblockPos += count;
+
+            if (m_subblockPos == m_subblockFrames) {
+                finishSubblock();
+            }
+        }
+    }
+
+    // Momentary loudness (LUFS)
+    float getMomentaryLoudness() const {
+        return energyToLoudness(averageEnergy(MOMENTARY_SUBBLOCKS));
+    }
+
+    // Short-term loudness (LUFS)
+    float getShortTermLoudness() const {
+        return energyToLoudness(averageEnergy(SHORT_TERM_SUBBLOCKS));
+    }
+
+    // Integrated loudness (LUFS), gated
+    float getIntegratedLoudness() const {
+        // Absolute gate: the histogram only holds blocks above LOUDNESS_FLOOR
+        size_t count = 0;
+        double energy = 0.0;
+        for (int i = 0; i < HISTOGRAM_BINS; i++) {
+            count += m_histogramCount[i];
+            energy += m_histogramEnergy[i];
+        }
+        if (count == 0) return LOUDNESS_FLOOR;
+
+        // Relative gate: -10 LU below the absolute-gated loudness
+        float relativeGate = energyToLoudness(energy / count) - 10.0f;
+        count = 0;
+        energy = 0.0;
+        for (int i = loudnessToBin(relativeGate); i < HISTOGRAM_BINS; i++) {
+            count += m_histogramCount[i];
+            energy += m_histogramEnergy[i];
+        }
+        if (count == 0) return LOUDNESS_FLOOR;
+        return energyToLoudness(energy / count);
+    }
+
+    // True peak (dBTP)
+    float getTruePeak() const {
+        if (m_truePeak <= 0.0f) return -INFINITY;
+        return 20.0f * std::log10(m_truePeak);
+    }
+
+    // Gain that brings the program to the target loudness.
+    // Uses integrated loudness once enough of the stream has been measured,
+    // short-term loudness before that.
+    float getNormalizationGain(float targetLoudness, float maxGain = 4.0f) const {
+        float loudness = m_gatingBlockCount >= SHORT_TERM_SUBBLOCKS
+            ? getIntegratedLoudness() : getShortTermLoudness();
+        if (loudness <= LOUDNESS_FLOOR) return 1.0f;
+
+        float gain = std::pow(10.0f, (targetLoudness - loudness) / 20.0f);
+        return std::clamp(gain, 1.0f / maxGain, maxGain);
+    }
+
+    // Peak amplitude of a 1 kHz sine, played on every channel, that measures
+    // this loudness (full-scale sine = 1). K-weighting gains about 0.691 dB at
+    // 1 kHz, cancelling the BS.1770 offset, and the weighted channels add up.
+    float loudnessToAmplitude(float loudness) const {
+        if (loudness <= LOUDNESS_FLOOR || m_channelWeightSum <= 0.0f) return 0.0f;
+        return std::pow(10.0f, loudness / 20.0f) * std::sqrt(2.0f / m_channelWeightSum);
+    }
+
+private:
+    static const int MOMENTARY_SUBBLOCKS = 4;     // 400 ms
+    static const int SHORT_TERM_SUBBLOCKS = 30;   // 3 s
+    static const int HISTOGRAM_BINS = 800;        // -70..+10 LUFS in 0.1 LU steps
+    static const int TRUE_PEAK_PHASES = 4;        // 4x oversampling
+    static const int TRUE_PEAK_TAPS = 12;         // Taps per phase
+    static const int TRUE_PEAK_HISTORY = TRUE_PEAK_TAPS - 1;  // Input samples carried between chunks
+
+    struct Biquad {
+        float b0 = 1.0f, b1 = 0.0f, b2 = 0.0f, a1 = 0.0f, a2 = 0.0f;
+    };
+
+    struct ChannelState {
+        float z1[2] = { 0.0f, 0.0f };  // Biquad states (transposed direct form II)
+        float z2[2] = { 0.0f, 0.0f };
+        double sumSquares = 0.0;       // K-weighted energy of the current sub-block
+        float history[TRUE_PEAK_HISTORY] = {};  // Last input samples, oldest first, for the oversampling filter
+    };
+
+    // K-weighting: high-shelf pre-filter followed by the RLB high-pass
+    void designKWeighting() {
+        const double pi = 3.14159265358979323846;
+        double rate = static_cast<double>(m_sampleRate);
+
+        double f0 = 1681.974450955533;
+        double gainDb = 3.999843853973347;
+        double q = 0.7071752369554196;
+        double k = std::tan(pi * f0 / rate);
+        double vh = std::pow(10.0, gainDb / 20.0);
+        double vb = std::pow(vh, 0.4996667741545416);
+        double a0 = 1.0 + k / q + k * k;
+        m_filters[0].b0 = static_cast<float>((vh + vb * k / q + k * k) / a0);
+        m_filters[0].b1 = static_cast<float>(2.0 * (k * k - vh) / a0);
+        m_filters[0].b2 = static_cast<float>((vh - vb * k / q + k * k) / a0);
+        m_filters[0].a1 = static_cast<float>(2.0 * (k * k - 1.0) / a0);
+        m_filters[0].a2 = static_cast<float>((1.0 - k / q + k * k) / a0);
+
+        f0 = 38.13547087602444;
+        q = 0.5003270373238773;
+        k = std::tan(pi * f0 / rate);
+        a0 = 1.0 + k / q + k * k;
+        m_filters[1].b0 = 1.0f;
+        m_filters[1].b1 = -2.0f;
+        m_filters[1].b2 = 1.0f;
+        m_filters[1].a1 = static_cast<float>(2.0 * (k * k - 1.0) / a0);
+        m_filters[1].a2 = static_cast<float>((1.0 - k / q + k * k) / a0);
+    }
+
+    // Polyphase windowed-sinc interpolation filter for 4x oversampling
+    void designTruePeakFilter() {
+        const double pi = 3.14159265358979323846;
+        const int length = TRUE_PEAK_PHASES * TRUE_PEAK_TAPS;
+        const double center = (length - 1) / 2.0;
+
+        for (int phase = 0; phase < TRUE_PEAK_PHASES; phase++) {
+            double sum = 0.0;
+            for (int tap = 0; tap < TRUE_PEAK_TAPS; tap++) {
+                int n = tap * TRUE_PEAK_PHASES + phase;
+                double x = (n - center) / TRUE_PEAK_PHASES;
+                double sinc = std::abs(x) < 1e-9 ? 1.0 : std::sin(pi * x) / (pi * x);
+                double window = 0.5 - 0.5 * std::cos(2.0 * pi * (n + 0.5) / length);  // Hann
+                m_truePeakFilter[phase][tap] = static_cast<float>(sinc * window);
+                sum += sinc * window;
+            }
+            // Unity gain per phase; stored reversed so that output i is a forward
+            // dot product over input[i .. i + TRUE_PEAK_TAPS)
+            float reversed[TRUE_PEAK_TAPS];
+            for (int tap = 0; tap < TRUE_PEAK_TAPS; tap++) {
+                reversed[TRUE_PEAK_TAPS - 1 - tap] = static_cast<float>(m_truePeakFilter[phase][tap] / sum);
+            }
+            std::copy(reversed, reversed + TRUE_PEAK_TAPS, m_truePeakFilter[phase]);
+        }
+    }
+
+    // BS.1770 channel weight for SFML/OpenAL channel order
+    static float channelWeight(unsigned int channel, unsigned int channels) {
+        const float SURROUND = 1.41f;
+        switch (channels) {
+        case 4:  // FL FR RL RR
+            return channel >= 2 ? SURROUND : 1.0f;
+        case 6:  // FL FR FC LFE RL RR
+        case 7:  // FL FR FC LFE RC SL SR
+        case 8:  // FL FR FC LFE RL RR SL SR
+            if (channel == 3) return 0.0f;
+            return channel >= 4 ? SURROUND : 1.0f;
+        default:
+            return 1.0f;
+        }
+    }
+
+    // Filter one channel of an interleaved chunk
+    void processChannel(ChannelState& state, float weight, const sf::Int16* samples, size_t count) {
+        // The oversampling filter's history sits in front of the chunk, so all
+        // block loops below run over contiguous memory
+        std::copy(state.history, state.history + TRUE_PEAK_HISTORY, m_channelBuffer.begin());
+        float* buffer = m_channelBuffer.data() + TRUE_PEAK_HISTORY;
+
+        // Deinterleave and convert
+        for (size_t i = 0; i < count; i++) {
+            buffer[i] = samples[i * m_channels] / 32768.0f;
+        }
+
+        updateTruePeak(state, count);
+        if (weight == 0.0f) return;  // LFE: true peak only
+
+        for (int f = 0; f < 2; f++) {
+            const Biquad& bq = m_filters[f];
+            float z1 = state.z1[f];
+            float z2 = state.z2[f];
+            for (size_t i = 0; i < count; i++) {
+                float in = buffer[i];
+                float out = bq.b0 * in + z1;
+                z1 = bq.b1 * in - bq.a1 * out + z2;
+                z2 = bq.b2 * in - bq.a2 * out;
+                buffer[i] = out;
+            }
+            state.z1[f] = z1;
+            state.z2[f] = z2;
+        }
+
+        double sumSquares = 0.0;
+        for (size_t i = 0; i < count; i++) {
+            sumSquares += buffer[i] * buffer[i];
+        }
+        state.sumSquares += weight * sumSquares;
+    }
+
+    // Peak of the 4x oversampled signal over m_channelBuffer
+    // (TRUE_PEAK_HISTORY samples of history followed by count new samples)
+    void updateTruePeak(ChannelState& state, size_t count) {
+        const float* input = m_channelBuffer.data();
+        float* output = m_phaseOutput.data();
+        float peak = m_truePeak;
+
+        // Sample peak
+        for (size_t i = 0; i < count; i++) {
+            peak = std::max(peak, std::abs(input[TRUE_PEAK_HISTORY + i]));
+        }
+
+        // One pass per phase and tap: the inner loops are independent
+        // multiply-adds over contiguous memory, so they vectorize
+        for (int phase = 0; phase < TRUE_PEAK_PHASES; phase++) {
+            const float* coeffs = m_truePeakFilter[phase];
+            std::fill(output, output + count, 0.0f);
+            for (int tap = 0; tap < TRUE_PEAK_TAPS; tap++) {
+                const float c = coeffs[tap];
+                const float* in = input + tap;
+                for (size_t i = 0; i < count; i++) {
+                    output[i] += c * in[i];
+                }
+            }
+            for (size_t i = 0; i < count; i++) {
+                peak = std::max(peak, std::abs(output[i]));
+            }
+        }
+        m_truePeak = peak;
+
+        // Carry the newest input samples over to the next chunk
+        std::copy(input + count, input + count + TRUE_PEAK_HISTORY, state.history);
+    }
+
+    // A 100 ms sub-block is complete: store its energy and update the gating histogram
+    void finishSubblock() {
+        double energy = 0.0;
+        for (auto& state : m_channelState) {
+            energy += state.sumSquares / m_subblockFrames;  // Already channel-weighted
+            state.sumSquares = 0.0;
+        }
+        m_subblockPos = 0;
+
+        m_subblockEnergy.push_back(energy);
+        if (m_subblockEnergy.size() > SHORT_TERM_SUBBLOCKS) {
+            m_subblockEnergy.erase(m_subblockEnergy.begin());
+        }
+
+        // 400 ms gating blocks with 75% overlap
+        if (m_subblockEnergy.size() >= MOMENTARY_SUBBLOCKS) {
+            double blockEnergy = averageEnergy(MOMENTARY_SUBBLOCKS);
+            float loudness = energyToLoudness(blockEnergy);
+            if (loudness > LOUDNESS_FLOOR) {
+                int bin = loudnessToBin(loudness);
+                m_histogramCount[bin]++;
+                m_histogramEnergy[bin] += blockEnergy;
+            }
+            m_gatingBlockCount++;
+        }
+    }
+
+    // Mean energy of the most recent sub-blocks
+    double averageEnergy(int subblocks) const {
+        int count = std::min<int>(subblocks, static_cast<int>(m_subblockEnergy.size()));
+        if (count == 0) return 0.0;
+
+        double sum = 0.0;
+        for (int i = 0; i < count; i++) {
+            sum += m_subblockEnergy[m_subblockEnergy.size() - 1 - i];
+        }
+        return sum / count;
+    }
+
+    static float energyToLoudness(double energy) {
+        if (energy <= 0.0) return LOUDNESS_FLOOR;
+        return std::max(LOUDNESS_FLOOR, static_cast<float>(-0.691 + 10.0 * std::log10(energy)));
+    }
+
+    static int loudnessToBin(float loudness) {
+        int bin = static_cast<int>((loudness - LOUDNESS_FLOOR) * 10.0f);
+        return std::clamp(bin, 0, HISTOGRAM_BINS - 1);
+    }
+
+    unsigned int m_sampleRate;
+    unsigned int m_channels;
+    size_t m_subblockFrames;    // Frames per 100 ms sub-block
+    size_t m_subblockPos;       // Frames already in the current sub-block
+
+    Biquad m_filters[2];
+    float m_truePeakFilter[TRUE_PEAK_PHASES][TRUE_PEAK_TAPS];
+
+    std::vector<ChannelState> m_channelState;
+    std::vector<float> m_channelWeights;  // BS.1770 channel weights
+    float m_channelWeightSum;             // Sum of the channel weights
+    std::vector<float> m_channelBuffer;   // Filter history + one channel of a chunk
+    std::vector<float> m_phaseOutput;     // One oversampling phase of a chunk
+    std::vector<double> m_subblockEnergy; // Last 3 s of sub-block energies
+
+    std::vector<size_t> m_histogramCount; // Gating blocks per loudness bin
+    std::vector<double> m_histogramEnergy;
+    size_t m_gatingBlockCount;
+
+    float m_truePeak;           // Linear true peak
+};
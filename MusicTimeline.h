@@ -3,6 +3,7 @@
 #include <string>
 #include <functional>
 #include <map>
+#include <algorithm>
 #include <iostream>
 #include <SFML/Graphics.hpp>
 
@@ -23,13 +24,31 @@ enum class VisualEventType {
 // ¼ṹ
 struct TimelineEvent {
     float time;                    // ʱ䣨룩
+    float duration;                // ʱ䣨룩0 ʾ˲ʱ¼
     VisualEventType type;          // ¼
     std::string description;       // ¼
     std::map<std::string, float> parameters;  // 
     bool triggered;                // ǷѴ
+    bool active;                   // ǰǷڳʱ
 
-    TimelineEvent(float t, VisualEventType ty, const std::string& desc = "")
-        : time(t), type(ty), description(desc), triggered(false) {
+    TimelineEvent(float t, VisualEventType ty, const std::string& desc = "", float dur = 0.0f)
+        : time(t), duration(dur), type(ty), description(desc), triggered(false), active(false) {
+    }
+
+    // ʱ
+    float getEndTime() const {
+        return time + duration;
+    }
+
+    //  t ʱǷڳʱڣ˲ʱ¼Զᴦڼ״̬
+    bool isActiveAt(float t) const {
+        return time <= t && t < getEndTime();
+    }
+
+    //  t ʱ̵Ľȣ0~1
+    float getProgress(float t) const {
+        if (duration <= 0.0f) return 1.0f;
+        return std::clamp((t - time) / duration, 0.0f, 1.0f);
     }
 
     // Ӳ
@@ -44,18 +63,88 @@ struct TimelineEvent {
     }
 };
 
+// ڽеĳ¼
+// event ָʱڲ¼һ addEvent ֮ʧЧʹ·䣩Ҫڱ
+struct ActiveEffect {
+    const TimelineEvent* event;
+    float progress;                // 0~1
+};
+
 // ʱ
+// ¼ʼʱ򣬲Ͻʽÿڵ¼Ľʱ䣩
+// ѯ"ĳһʱЩЧڽ"ֻʿཻ O(k log n)k Ϊ
+// תѭŶҪȫ¼
 class MusicTimeline {
 private:
     std::vector<TimelineEvent> events;
+    std::vector<float> maxEndTimes;    //  mid ΪĽʱ
+    std::vector<size_t> activeIndices; // ǰĳ¼±
+    size_t nextEventIndex;             // һδ¼
     float currentTime;
     bool isPlaying;
 
     // صϵͳ
     std::map<VisualEventType, std::function<void(const TimelineEvent&)>> callbacks;
+    // ¼Ľ/˳֪ͨʱнȣת¼мʱΪ0
+    std::map<VisualEventType, std::function<void(const TimelineEvent&, float)>> enterCallbacks;
+    std::map<VisualEventType, std::function<void(const TimelineEvent&)>> exitCallbacks;
+
+    // һʼʱ䲻 time ¼±
+    size_t firstEventAtOrAfter(float time) const {
+        return std::lower_bound(events.begin(), events.end(), time,
+            [](const TimelineEvent& e, float t) {
+                return e.time < t;
+            }) - events.begin();
+    }
+
+    //  [lo, hi) ΧĽʱ
+    float buildIndex(size_t lo, size_t hi) {
+        if (lo >= hi) return -1.0f;
+        size_t mid = (lo + hi) / 2;
+        float maxEnd = events[mid].getEndTime();
+        maxEnd = std::max(maxEnd, buildIndex(lo, mid));
+        maxEnd = std::max(maxEnd, buildIndex(mid + 1, hi));
+        maxEndTimes[mid] = maxEnd;
+        return maxEnd;
+    }
+
+    // ѯ [lo, hi) Χ time ʱ̼¼±˳
+    void queryActive(size_t lo, size_t hi, float time, std::vector<size_t>& result) const {
+        if (lo >= hi) return;
+        size_t mid = (lo + hi) / 2;
+        if (maxEndTimes[mid] <= time) return; // ѽ
+
+        queryActive(lo, mid, time, result);
+        if (events[mid].time <= time) {
+            if (events[mid].isActiveAt(time)) result.push_back(mid);
+            queryActive(mid + 1, hi, time, result);
+        }
+    }
+
+    // Ƚ¾ɼϣ˳/֪ͨ
+    void updateActiveEvents() {
+        std::vector<size_t> nowActive;
+        queryActive(0, events.size(), currentTime, nowActive);
+
+        for (size_t index : activeIndices) {
+            if (!std::binary_search(nowActive.begin(), nowActive.end(), index)) {
+                events[index].active = false;
+                auto it = exitCallbacks.find(events[index].type);
+                if (it != exitCallbacks.end()) it->second(events[index]);
+            }
+        }
+        for (size_t index : nowActive) {
+            if (!events[index].active) {
+                events[index].active = true;
+                auto it = enterCallbacks.find(events[index].type);
+                if (it != enterCallbacks.end()) it->second(events[index], events[index].getProgress(currentTime));
+            }
+        }
+        activeIndices.swap(nowActive);
+    }
 
 public:
-    MusicTimeline() : currentTime(0.0f), isPlaying(false) {
+    MusicTimeline() : nextEventIndex(0), currentTime(0.0f), isPlaying(false) {
         // ʼĬϻصպ
         for (int i = 0; i < static_cast<int>(VisualEventType::MELODY_HIGHLIGHT) + 1; i++) {
             callbacks[static_cast<VisualEventType>(i)] = [](const TimelineEvent&) {};
@@ -64,12 +153,31 @@ public:
 
     // ¼
     void addEvent(const TimelineEvent& event) {
-        events.push_back(event);
-        // ʱ
-        std::sort(events.begin(), events.end(),
-            [](const TimelineEvent& a, const TimelineEvent& b) {
-                return a.time < b.time;
+        TimelineEvent newEvent = event;
+        // ݾдʱд parameters["duration"] 
+        if (newEvent.duration <= 0.0f) {
+            newEvent.duration = std::max(0.0f, newEvent.getParam("duration"));
+        }
+        //  seek Ĺһ£Ѿȥ˲ʱ¼ٲ
+        newEvent.triggered = newEvent.time < currentTime;
+        newEvent.active = false;
+
+        // ʱ루ͬʱ䱣˳
+        auto pos = std::upper_bound(events.begin(), events.end(), newEvent.time,
+            [](float t, const TimelineEvent& e) {
+                return t < e.time;
             });
+        events.insert(pos, newEvent);
+
+        maxEndTimes.assign(events.size(), 0.0f);
+        buildIndex(0, events.size());
+
+        // ±ı䣬ͬαͼб
+        nextEventIndex = firstEventAtOrAfter(currentTime);
+        activeIndices.clear();
+        for (size_t i = 0; i < events.size(); i++) {
+            if (events[i].active) activeIndices.push_back(i);
+        }
     }
 
     // ûص
@@ -77,19 +185,38 @@ public:
         callbacks[type] = callback;
     }
 
+    // ó¼ĽصΪʱĽȣ
+    void setEnterCallback(VisualEventType type, std::function<void(const TimelineEvent&, float)> callback) {
+        enterCallbacks[type] = callback;
+    }
+
+    // ó¼˳ص
+    void setExitCallback(VisualEventType type, std::function<void(const TimelineEvent&)> callback) {
+        exitCallbacks[type] = callback;
+    }
+
     // ʱ
     void update(float audioTime) {
         if (!isPlaying) return;
 
+        // ʱ䵹ˣѭŻ϶תǰƽʱ˲ʱ¼ᴥ
+        // ʹһ֡Խ˺ܳʱ䣨ʱҲʧǰ϶ʽ seek
+        if (audioTime < currentTime) {
+            seek(audioTime);
+        }
+
         currentTime = audioTime;
 
-        // 鲢¼
-        for (auto& event : events) {
-            if (!event.triggered && currentTime >= event.time) {
+        // 鲢¼αʱƽÿ֡ȫ¼
+        while (nextEventIndex < events.size() && events[nextEventIndex].time <= currentTime) {
+            TimelineEvent& event = events[nextEventIndex++];
+            if (!event.triggered) {
                 triggerEvent(event);
                 event.triggered = true;
             }
         }
+
+        updateActiveEvents();
     }
 
     // ¼
@@ -102,12 +229,27 @@ public:
         }
     }
 
+    // һʵʱ⵽˲ʱ¼ʶ𣩣ֻûصʱᣬ
+    // ˲ getActiveEvents УҲûн/˳֪ͨ
+    void fireEvent(const TimelineEvent& event) {
+        TimelineEvent liveEvent = event;
+        triggerEvent(liveEvent);
+    }
+
     // ʱ
     void reset() {
         currentTime = 0.0f;
+        nextEventIndex = 0;
         for (auto& event : events) {
             event.triggered = false;
         }
+        // ڽеЧյ˳֪ͨ
+        for (size_t index : activeIndices) {
+            events[index].active = false;
+            auto it = exitCallbacks.find(events[index].type);
+            if (it != exitCallbacks.end()) it->second(events[index]);
+        }
+        activeIndices.clear();
     }
 
     // ſ
@@ -123,19 +265,40 @@ public:
 
     // ȡһ¼ʱ
     float getNextEventTime() const {
-        for (const auto& event : events) {
-            if (!event.triggered) return event.time;
-        }
+        if (nextEventIndex < events.size()) return events[nextEventIndex].time;
         return -1.0f; // ûи¼
     }
 
     // ֶתĳʱ
+    // ֮ǰ˲ʱ¼Ჹλ time ¼һ update
+    // ¼мʱЧյȵĽ֪ͨ
     void seek(float time) {
         currentTime = time;
-        // time֮¼
-        for (auto& event : events) {
-            event.triggered = (event.time <= time);
+        nextEventIndex = firstEventAtOrAfter(time);
+        // дtimeʼ¼
+        for (size_t i = 0; i < events.size(); i++) {
+            events[i].triggered = (i < nextEventIndex);
         }
+        updateActiveEvents();
+    }
+
+    // ѯʱڽеЧȣıʱ״̬
+    // صָֻһ addEvent ֮ǰЧ
+    std::vector<ActiveEffect> getActiveEvents(float time) const {
+        std::vector<size_t> indices;
+        queryActive(0, events.size(), time, indices);
+
+        std::vector<ActiveEffect> result;
+        result.reserve(indices.size());
+        for (size_t index : indices) {
+            result.push_back({ &events[index], events[index].getProgress(time) });
+        }
+        return result;
+    }
+
+    // ǰʱڽеЧ
+    std::vector<ActiveEffect> getActiveEvents() const {
+        return getActiveEvents(currentTime);
     }
 
     // ´½רʱ
@@ -154,9 +317,8 @@ public:
 
         // 0:17 ʷʫ
         TimelineEvent epicEvent(17.0f, VisualEventType::EPIC_EXPLOSION,
-            "ɱʷʫ");
+            "ɱʷʫ", 2.0f);
         epicEvent.addParam("intensity", 1.0f);
-        epicEvent.addParam("duration", 2.0f);
         timeline.addEvent(epicEvent);
 
         timeline.addEvent(TimelineEvent(17.1f, VisualEventType::SCREEN_SHAKE,
@@ -166,17 +328,18 @@ public:
         timeline.addEvent(TimelineEvent(44.0f, VisualEventType::VIOLIN_SOLO,
             "Сٶ࿪ʼ"));
 
-        // 0:56 ٴμ
-        timeline.addEvent(TimelineEvent(56.0f, VisualEventType::COLOR_CHANGE,
-            "ɫɫ"));
+        // 0:56 ٴμɫ 4 ڽΪɫֵ
+        TimelineEvent colorEvent(56.0f, VisualEventType::COLOR_CHANGE,
+            "ɫɫ", 17.0f);
+        colorEvent.addParam("fade", 4.0f);
+        timeline.addEvent(colorEvent);
 
         // 1:13 
         timeline.addEvent(TimelineEvent(73.0f, VisualEventType::BACKGROUND_CHANGE,
             "ҶΪýɫ"));
 
         // ضɣmi-fa-so-fa-mi
-        timeline.addEvent(TimelineEvent(17.5f, VisualEventType::MELODY_HIGHLIGHT,
-            "ɸ"));
+        // ֶдʱ䣬 PitchTracker ʵʱʶͨ fireEvent  MELODY_HIGHLIGHT
 
         return timeline;
     }
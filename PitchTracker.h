@@ -0,0 +1,369 @@
+#pragma once
+#include <SFML/Config.hpp>
+#include <vector>
+#include <deque>
+#include <string>
+#include <complex>
+#include <functional>
+#include <cmath>
+#include <algorithm>
+#include <cstddef>
+#include "MusicTimeline.h"
+
+// Result of one analysis hop
+struct PitchFrame {
+    float time = 0.0f;          // Stream time of the analysis window center (seconds)
+    float frequency = 0.0f;     // Detected fundamental (Hz), 0 if unvoiced
+    float confidence = 0.0f;    // 1 - YIN aperiodicity (0..1)
+    int midiNote = -1;          // Nearest MIDI note, -1 if unvoiced
+    float chroma[12] = {};      // Pitch class energy (C, C#, ... B), normalized to max 1
+};
+
+// A melodic pattern described by the semitone steps between successive notes,
+// so it matches in any key. E.g. mi-fa-so-fa-mi = { +1, +2, -2, -1 }.
+struct MelodyPattern {
+    std::string name;
+    std::vector<int> intervals;
+    VisualEventType eventType;
+    float maxNoteGap;           // Max seconds between two notes of the pattern
+
+    MelodyPattern(const std::string& n, const std::vector<int>& steps,
+        VisualEventType type = VisualEventType::MELODY_HIGHLIGHT, float gap = 1.5f)
+        : name(n), intervals(steps), eventType(type), maxNoteGap(gap) {
+    }
+};
+
+// Streaming pitch and chroma tracker.
+//
+// Every hop (10 ms by default) the latest window is analyzed with YIN, using
+// an FFT-based autocorrelation for the difference function, and a 12-bin
+// chroma vector is taken from the same spectrum pass. Stable notes are
+// collected into a short history and matched against the configured
+// melodic patterns; a match produces a TimelineEvent passed to the callback.
+class PitchTracker {
+public:
+    PitchTracker(unsigned int sampleRate = 44100, unsigned int channels = 2,
+        size_t windowSize = 2048, float hopSeconds = 0.01f) {
+        configure(sampleRate, channels, windowSize, hopSeconds);
+    }
+
+    // Change the stream format (also resets the tracker).
+    // windowSize is rounded up to a power of two.
+    void configure(unsigned int sampleRate, unsigned int channels,
+        size_t windowSize = 2048, float hopSeconds = 0.01f) {
+        m_sampleRate = std::max(1u, sampleRate);
+        m_channels = std::max(1u, channels);
+
+        m_windowSize = 64;
+        while (m_windowSize < windowSize) m_windowSize *= 2;
+        m_hopSize = std::max<size_t>(1, static_cast<size_t>(hopSeconds * m_sampleRate));
+
+        // Twiddle factors and bit reversal table for the FFT
+        const float pi = 3.14159265358979f;
+        m_twiddles.resize(m_windowSize / 2);
+        for (size_t i = 0; i < m_twiddles.size(); i++) {
+            m_twiddles[i] = std::polar(1.0f, -2.0f * pi * i / m_windowSize);
+        }
+        m_bitReverse.resize(m_windowSize);
+        int bits = 0;
+        while ((size_t(1) << bits) < m_windowSize) bits++;
+        for (size_t i = 0; i < m_windowSize; i++) {
+            size_t r = 0;
+            for (int b = 0; b < bits; b++) {
+                if (i & (size_t(1) << b)) r |= size_t(1) << (bits - 1 - b);
+            }
+            m_bitReverse[i] = r;
+        }
+
+        m_hannWindow.resize(m_windowSize);
+        for (size_t i = 0; i < m_windowSize; i++) {
+            m_hannWindow[i] = 0.5f - 0.5f * std::cos(2.0f * pi * i / m_windowSize);
+        }
+
+        // Chroma bin of every FFT bin (-1 outside the musical range)
+        m_chromaBin.assign(m_windowSize / 2, -1);
+        for (size_t k = 1; k < m_windowSize / 2; k++) {
+            float freq = static_cast<float>(k) * m_sampleRate / m_windowSize;
+            if (freq < MIN_CHROMA_FREQ || freq > MAX_CHROMA_FREQ) continue;
+            int note = static_cast<int>(std::lround(frequencyToMidi(freq)));
+            m_chromaBin[k] = ((note % 12) + 12) % 12;
+        }
+
+        m_ring.assign(m_windowSize, 0.0f);
+        m_frame.resize(m_windowSize);
+        m_spectrum.resize(m_windowSize);
+        m_integration.resize(m_windowSize);
+        m_difference.resize(m_windowSize / 2);
+        reset();
+    }
+
+    // Clear analysis state (call after seeking or restarting playback)
+    void reset() {
+        std::fill(m_ring.begin(), m_ring.end(), 0.0f);
+        m_ringPos = 0;
+        m_hopPos = 0;
+        m_framesProcessed = 0;
+        m_latest = PitchFrame();
+        m_candidateNote = -1;
+        m_candidateHops = 0;
+        m_candidateStart = 0.0f;
+        m_notes.clear();
+    }
+
+    // Add a melodic pattern to watch for
+    void addPattern(const MelodyPattern& pattern) {
+        m_patterns.push_back(pattern);
+    }
+
+    // Called with an event whenever a pattern matches
+    void setPatternCallback(std::function<void(const TimelineEvent&)> callback) {
+        m_patternCallback = callback;
+    }
+
+    // Feed interleaved frames (downmixed to mono internally)
+    void process(const sf::Int16* samples, size_t frameCount) {
+        for (size_t i = 0; i < frameCount; i++) {
+            float sum = 0.0f;
+            for (unsigned int c = 0; c < m_channels; c++) {
+                sum += samples[i * m_channels + c];
+            }
+            m_ring[m_ringPos] = sum / (32768.0f * m_channels);
+            m_ringPos = (m_ringPos + 1) % m_windowSize;
+            m_framesProcessed++;
+
+            if (++m_hopPos == m_hopSize) {
+                m_hopPos = 0;
+                if (m_framesProcessed >= m_windowSize) {
+                    analyze();
+                }
+            }
+        }
+    }
+
+    // Most recent analysis result
+    const PitchFrame& getLatestFrame() const {
+        return m_latest;
+    }
+
+    // Note name for display, e.g. "A4"
+    static std::string noteName(int midiNote) {
+        static const char* NAMES[12] = { "C", "C#", "D", "D#", "E", "F", "F#", "G", "G#", "A", "A#", "B" };
+        if (midiNote < 0) return "-";
+        return std::string(NAMES[midiNote % 12]) + std::to_string(midiNote / 12 - 1);
+    }
+
+    static float frequencyToMidi(float frequency) {
+        return 69.0f + 12.0f * std::log2(frequency / 440.0f);
+    }
+
+private:
+    static constexpr float YIN_THRESHOLD = 0.15f;     // Absolute threshold on the CMND function
+    static constexpr float MIN_VOICED_RMS = 0.003f;   // About -50 dBFS; quieter hops are unvoiced
+    static constexpr float MIN_FREQUENCY = 60.0f;     // Pitch search range (Hz)
+    static constexpr float MAX_FREQUENCY = 2000.0f;
+    static constexpr float MIN_CHROMA_FREQ = 55.0f;   // Chroma range (Hz)
+    static constexpr float MAX_CHROMA_FREQ = 5000.0f;
+    static const int MIN_NOTE_HOPS = 5;               // Hops a note must hold to count (50 ms)
+    static const size_t NOTE_HISTORY = 16;
+
+    struct NoteOnset {
+        int midiNote;
+        float time;
+    };
+
+    // In-place iterative radix-2 FFT of size m_windowSize
+    void fft(std::vector<std::complex<float>>& data, bool inverse) const {
+        const size_t n = m_windowSize;
+        for (size_t i = 0; i < n; i++) {
+            size_t j = m_bitReverse[i];
+            if (i < j) std::swap(data[i], data[j]);
+        }
+        for (size_t len = 2; len <= n; len *= 2) {
+            size_t half = len / 2;
+            size_t step = n / len;
+            for (size_t start = 0; start < n; start += len) {
+                for (size_t k = 0; k < half; k++) {
+                    std::complex<float> w = m_twiddles[k * step];
+                    if (inverse) w = std::conj(w);
+                    std::complex<float> t = w * data[start + k + half];
+                    data[start + k + half] = data[start + k] - t;
+                    data[start + k] += t;
+                }
+            }
+        }
+        if (inverse) {
+            float scale = 1.0f / n;
+            for (auto& v : data) v *= scale;
+        }
+    }
+
+    void analyze() {
+        const size_t n = m_windowSize;
+        const size_t w = n / 2;  // YIN integration window
+
+        // Unroll the ring buffer, oldest sample first
+        for (size_t i = 0; i < n; i++) {
+            m_frame[i] = m_ring[(m_ringPos + i) % n];
+        }
+
+        PitchFrame result;
+        result.time = static_cast<float>(m_framesProcessed - n / 2) / m_sampleRate;
+
+        // Chroma from the windowed spectrum
+        for (size_t i = 0; i < n; i++) {
+            m_spectrum[i] = std::complex<float>(m_frame[i] * m_hannWindow[i], 0.0f);
+        }
+        fft(m_spectrum, false);
+        float maxChroma = 0.0f;
+        for (size_t k = 1; k < n / 2; k++) {
+            int bin = m_chromaBin[k];
+            if (bin >= 0) result.chroma[bin] += std::norm(m_spectrum[k]);
+        }
+        for (float c : result.chroma) maxChroma = std::max(maxChroma, c);
+        if (maxChroma > 0.0f) {
+            for (float& c : result.chroma) c /= maxChroma;
+        }
+
+        // r(tau) = sum_{j<w} x[j] * x[j + tau] as the cross-correlation of the
+        // first half with the whole frame; no circular wrap for tau < w
+        for (size_t i = 0; i < n; i++) {
+            m_spectrum[i] = std::complex<float>(m_frame[i], 0.0f);
+            m_integration[i] = std::complex<float>(i < w ? m_frame[i] : 0.0f, 0.0f);
+        }
+        fft(m_spectrum, false);
+        fft(m_integration, false);
+        for (size_t i = 0; i < n; i++) {
+            m_spectrum[i] *= std::conj(m_integration[i]);
+        }
+        fft(m_spectrum, true);
+
+        // Difference function d(tau) = e(0) + e(tau) - 2 r(tau),
+        // where e(tau) is the energy of x[tau .. tau + w)
+        float energy = 0.0f;
+        for (size_t j = 0; j < w; j++) energy += m_frame[j] * m_frame[j];
+        float e0 = energy;
+        float eTau = energy;
+        for (size_t tau = 0; tau < w; tau++) {
+            m_difference[tau] = std::max(0.0f, e0 + eTau - 2.0f * m_spectrum[tau].real());
+            eTau += m_frame[tau + w] * m_frame[tau + w] - m_frame[tau] * m_frame[tau];
+        }
+
+        // Cumulative mean normalized difference
+        m_difference[0] = 1.0f;
+        float runningSum = 0.0f;
+        for (size_t tau = 1; tau < w; tau++) {
+            runningSum += m_difference[tau];
+            m_difference[tau] = runningSum > 0.0f ? m_difference[tau] * tau / runningSum : 1.0f;
+        }
+
+        // First dip below the threshold inside the search range
+        size_t minTau = std::max<size_t>(2, static_cast<size_t>(m_sampleRate / MAX_FREQUENCY));
+        size_t maxTau = std::min(w - 2, static_cast<size_t>(m_sampleRate / MIN_FREQUENCY));
+        size_t bestTau = 0;
+        for (size_t tau = minTau; tau <= maxTau; tau++) {
+            if (m_difference[tau] < YIN_THRESHOLD) {
+                while (tau + 1 <= maxTau && m_difference[tau + 1] < m_difference[tau]) tau++;
+                bestTau = tau;
+                break;
+            }
+        }
+
+        // Voicing: a dip below YIN_THRESHOLD (so confidence > 0.85) and enough
+        // signal energy, so near-silent noise or reverb tails are not tracked
+        float rms = std::sqrt(e0 / w);
+        if (bestTau > 0 && rms >= MIN_VOICED_RMS) {
+            // Parabolic interpolation around the minimum
+            float a = m_difference[bestTau - 1];
+            float b = m_difference[bestTau];
+            float c = m_difference[bestTau + 1];
+            float denom = a - 2.0f * b + c;
+            float shift = std::abs(denom) > 1e-9f ? 0.5f * (a - c) / denom : 0.0f;
+            float period = bestTau + std::clamp(shift, -1.0f, 1.0f);
+
+            result.confidence = std::clamp(1.0f - b, 0.0f, 1.0f);
+            if (period > 0.0f) {
+                result.frequency = m_sampleRate / period;
+                result.midiNote = static_cast<int>(std::lround(frequencyToMidi(result.frequency)));
+            }
+        }
+
+        m_latest = result;
+        trackNotes(result);
+    }
+
+    // Turn per-hop notes into stable note onsets and match patterns
+    void trackNotes(const PitchFrame& frame) {
+        if (frame.midiNote != m_candidateNote) {
+            m_candidateNote = frame.midiNote;
+            m_candidateHops = 0;
+            m_candidateStart = frame.time;
+        }
+        if (m_candidateNote < 0 || ++m_candidateHops != MIN_NOTE_HOPS) return;
+
+        // The candidate just became a stable note; repeated notes are merged
+        if (!m_notes.empty() && m_notes.back().midiNote == m_candidateNote) return;
+
+        m_notes.push_back({ m_candidateNote, m_candidateStart });
+        if (m_notes.size() > NOTE_HISTORY) m_notes.pop_front();
+
+        for (const auto& pattern : m_patterns) {
+            if (matches(pattern)) {
+                float start = m_notes[m_notes.size() - 1 - pattern.intervals.size()].time;
+                // Reported once the last note is stable, so the motif is already over:
+                // it is an instant event at the motif's first note, not a range
+                TimelineEvent event(start, pattern.eventType, pattern.name);
+                event.addParam("note", static_cast<float>(m_notes.back().midiNote));
+                event.triggered = true;
+
+                // Start over so overlapping notes do not fire the same match again
+                m_notes.clear();
+                if (m_patternCallback) m_patternCallback(event);
+                break;
+            }
+        }
+    }
+
+    bool matches(const MelodyPattern& pattern) const {
+        size_t count = pattern.intervals.size();
+        if (count == 0 || m_notes.size() < count + 1) return false;
+
+        size_t first = m_notes.size() - 1 - count;
+        for (size_t i = 0; i < count; i++) {
+            const NoteOnset& from = m_notes[first + i];
+            const NoteOnset& to = m_notes[first + i + 1];
+            if (to.midiNote - from.midiNote != pattern.intervals[i]) return false;
+            if (to.time - from.time > pattern.maxNoteGap) return false;
+        }
+        return true;
+    }
+
+    unsigned int m_sampleRate;
+    unsigned int m_channels;
+    size_t m_windowSize;        // Analysis window (power of two)
+    size_t m_hopSize;           // Frames between analyses
+
+    std::vector<std::complex<float>> m_twiddles;
+    std::vector<size_t> m_bitReverse;
+    std::vector<float> m_hannWindow;
+    std::vector<int> m_chromaBin;
+
+    std::vector<float> m_ring;  // Last m_windowSize mono samples
+    size_t m_ringPos;
+    size_t m_hopPos;
+    size_t m_framesProcessed;
+
+    std::vector<float> m_frame;
+    std::vector<std::complex<float>> m_spectrum;
+    std::vector<std::complex<float>> m_integration;
+    std::vector<float> m_difference;
+
+    PitchFrame m_latest;
+
+    int m_candidateNote;
+    int m_candidateHops;
+    float m_candidateStart;
+    std::deque<NoteOnset> m_notes;
+
+    std::vector<MelodyPattern> m_patterns;
+    std::function<void(const TimelineEvent&)> m_patternCallback;
+};
@@ -0,0 +1,175 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <string>
+
+// One set of quality levers used by the visualizer
+struct QualitySettings {
+    const char* name;       // Tier name shown in the HUD
+    int waveformPoints;     // Number of waveform points
+    int thicknessPasses;    // Number of passes used to draw the thick waveform line
+    int particleCount;      // Number of background particles drawn
+    size_t analysisSize;    // Analysis window size (samples per frame)
+};
+
+// Quality tiers, from cheapest to most expensive.
+// "High" matches the original compile-time constants.
+static const QualitySettings QUALITY_TIERS[] = {
+    { "Low",     150,  5,  30, 1024 },
+    { "Medium",  300, 11,  60, 2048 },
+    { "High",    500, 21, 100, 4096 },
+    { "Ultra",  1000, 31, 200, 8192 },
+};
+static const int QUALITY_TIER_COUNT = sizeof(QUALITY_TIERS) / sizeof(QUALITY_TIERS[0]);
+
+// Adaptive quality governor: watches measured frame times and moves
+// between quality tiers to hold a target frame rate.
+//
+// addFrameTime() takes two measurements:
+//   - work time: CPU time spent building the frame, excluding the frame
+//     limiter wait, so a capped frame rate does not hide headroom
+//   - frame interval: the real time between frames. Draw calls are deferred,
+//     so driver/GPU cost only shows up here (in display() and buffer swap).
+// A frame counts as over budget if either is too long, and upgrades are
+// only allowed while the real interval is meeting the target.
+//
+// Hysteresis: a tier is dropped quickly when the budget is exceeded and
+// raised slowly when there is plenty of headroom, and every change is
+// followed by a cooldown so the tier does not oscillate.
+class QualityGovernor {
+public:
+    QualityGovernor(float targetFps = 60.0f, int initialTier = 2)
+        : m_targetFps(targetFps),
+        m_tier(std::clamp(initialTier, 0, QUALITY_TIER_COUNT - 1)),
+        m_averageFrameTime(0.0f),
+        m_averageInterval(0.0f),
+        m_overBudgetTime(0.0f),
+        m_underBudgetTime(0.0f),
+        m_cooldown(0.0f),
+        m_enabled(true) {
+    }
+
+    // Feed the work time and the real interval of the last frame (seconds).
+    // Returns true if the quality tier changed.
+    bool addFrameTime(float workTime, float frameInterval) {
+        if (workTime <= 0.0f || frameInterval <= 0.0f) return false;
+
+        // A single stall (window drag, loading) should not count as seconds over budget
+        frameInterval = std::min(frameInterval, MAX_INTERVAL_LOAD * getFrameBudget());
+
+        // Exponential moving averages, so single spikes do not trigger a change
+        if (m_averageFrameTime <= 0.0f) m_averageFrameTime = workTime;
+        m_averageFrameTime += (workTime - m_averageFrameTime) * AVERAGE_WEIGHT;
+        if (m_averageInterval <= 0.0f) m_averageInterval = frameInterval;
+        m_averageInterval += (frameInterval - m_averageInterval) * AVERAGE_WEIGHT;
+
+        if (!m_enabled) return false;
+
+        // Advance timers in wall time
+        float elapsed = frameInterval;
+
+        if (m_cooldown > 0.0f) {
+            m_cooldown -= elapsed;
+            return false;
+        }
+
+        float load = m_averageFrameTime / getFrameBudget();
+        float intervalLoad = m_averageInterval / getFrameBudget();
+
+        if (load > DOWNGRADE_LOAD || intervalLoad > MISSED_INTERVAL_LOAD) {
+            m_overBudgetTime += elapsed;
+            m_underBudgetTime = 0.0f;
+        }
+        else if (load < UPGRADE_LOAD && intervalLoad <= TARGET_INTERVAL_LOAD) {
+            m_underBudgetTime += elapsed;
+            m_overBudgetTime = 0.0f;
+        }
+        else {
+            m_overBudgetTime = 0.0f;
+            m_underBudgetTime = 0.0f;
+        }
+
+        if (m_overBudgetTime >= DOWNGRADE_DELAY && m_tier > 0) {
+            return changeTier(m_tier - 1);
+        }
+        if (m_underBudgetTime >= UPGRADE_DELAY && m_tier < QUALITY_TIER_COUNT - 1) {
+            return changeTier(m_tier + 1);
+        }
+        return false;
+    }
+
+    // Set target frame rate (e.g. 60 or 144)
+    void setTargetFps(float fps) {
+        m_targetFps = std::max(1.0f, fps);
+        m_overBudgetTime = 0.0f;
+        m_underBudgetTime = 0.0f;
+        m_cooldown = COOLDOWN;
+    }
+
+    // Manually force a tier (also used when the governor is disabled)
+    void setTier(int tier) {
+        changeTier(std::clamp(tier, 0, QUALITY_TIER_COUNT - 1));
+    }
+
+    void setEnabled(bool enabled) {
+        m_enabled = enabled;
+        m_overBudgetTime = 0.0f;
+        m_underBudgetTime = 0.0f;
+    }
+
+    bool isEnabled() const { return m_enabled; }
+    int getTier() const { return m_tier; }
+    const QualitySettings& getSettings() const { return QUALITY_TIERS[m_tier]; }
+    float getTargetFps() const { return m_targetFps; }
+    float getFrameBudget() const { return 1.0f / m_targetFps; }
+    float getAverageFrameTime() const { return m_averageFrameTime; }
+    float getAverageInterval() const { return m_averageInterval; }
+
+    // Short status line for the HUD (changes only with the tier or settings)
+    std::string getStatusText() const {
+        std::string text = "Quality: " + std::string(getSettings().name);
+        text += " (" + std::to_string(m_tier + 1) + "/" + std::to_string(QUALITY_TIER_COUNT) + ")";
+        text += m_enabled ? " auto" : " fixed";
+        text += "\nTarget FPS: " + std::to_string(static_cast<int>(m_targetFps));
+        return text;
+    }
+
+    // Measured frame times for the HUD, rounded to 0.1 ms
+    std::string getFrameStatsText() const {
+        int work = static_cast<int>(std::lround(m_averageFrameTime * 10000.0f));
+        int interval = static_cast<int>(std::lround(m_averageInterval * 10000.0f));
+        std::string text = "Frame work: " + std::to_string(work / 10) + "." + std::to_string(work % 10) + " ms";
+        text += "\nFrame interval: " + std::to_string(interval / 10) + "." + std::to_string(interval % 10) + " ms";
+        return text;
+    }
+
+private:
+    bool changeTier(int newTier) {
+        m_overBudgetTime = 0.0f;
+        m_underBudgetTime = 0.0f;
+        m_cooldown = COOLDOWN;
+        if (newTier == m_tier) return false;
+        m_tier = newTier;
+        return true;
+    }
+
+    static constexpr float AVERAGE_WEIGHT = 0.1f;   // EMA weight of the newest frame
+    static constexpr float DOWNGRADE_LOAD = 0.9f;   // Drop a tier above 90% of the budget
+    static constexpr float UPGRADE_LOAD = 0.5f;     // Raise a tier below 50% of the budget
+    static constexpr float MISSED_INTERVAL_LOAD = 1.2f;  // Real interval clearly missing the target
+    static constexpr float MAX_INTERVAL_LOAD = 4.0f;     // Longer intervals are clamped (stalls)
+    static constexpr float TARGET_INTERVAL_LOAD = 1.05f; // Real interval meeting the target (limiter jitter allowed)
+    static constexpr float DOWNGRADE_DELAY = 0.5f;  // Seconds over budget before dropping
+    static constexpr float UPGRADE_DELAY = 3.0f;    // Seconds of headroom before raising
+    static constexpr float COOLDOWN = 1.0f;         // Seconds to wait after any change
+
+    float m_targetFps;
+    int m_tier;
+    float m_averageFrameTime;   // Average work time
+    float m_averageInterval;    // Average real frame interval
+    float m_overBudgetTime;
+    float m_underBudgetTime;
+    float m_cooldown;
+    bool m_enabled;
+};
@@ -1,37 +1,69 @@
 #pragma once
 #include <SFML/Graphics.hpp> // Ϊ֧ sf::Color 
+#include <cmath>
+#include <algorithm>
+
+// ֵ֮ľ루ж϶ǷѾ
+inline float smoothValueDistance(float a, float b) {
+    return std::abs(a - b);
+}
+
+inline float smoothValueDistance(const sf::Vector2f& a, const sf::Vector2f& b) {
+    return std::max(std::abs(a.x - b.x), std::abs(a.y - b.y));
+}
 
 // һģ࣬ζڶͣfloat, sf::Vector2f, sf::Color
 template <typename T>
 class SmoothValue {
 public:
-    // 캯ʼǰֵĿֵƽϵ
-    SmoothValue(const T& initialValue, float smoothFactor = 8.0f)
-        : m_current(initialValue), m_target(initialValue), m_smoothFactor(smoothFactor) {
+    // 캯ʼǰֵĿֵƽϵֵ
+    SmoothValue(const T& initialValue, float smoothFactor = 8.0f, float epsilon = 0.001f)
+        : m_current(initialValue), m_target(initialValue), m_smoothFactor(smoothFactor),
+        m_epsilon(epsilon), m_sleeping(true), m_version(0) {
     }
 
     // ÿһ֡õĸºdtһ֡һ֡ʱ䣨룩
+    // ߣʱֱӷأκμ
     void update(float dt) {
+        if (m_sleeping) return;
+
         // ƽʽԲֵ (LERP)
         //  m_current ָ˥ķʽޱƽ m_target
         m_current = m_current + (m_target - m_current) * m_smoothFactor * dt;
+        m_version++;
+
+        // ֵΧֱĿֵ
+        if (smoothValueDistance(m_current, m_target) <= m_epsilon) {
+            m_current = m_target;
+            m_sleeping = true;
+        }
     }
 
     // ĿֵҪմﵽֵ
+    // ֻỽеĶ
     void setTarget(const T& newTarget) {
         m_target = newTarget;
+        if (smoothValueDistance(m_current, m_target) > m_epsilon) {
+            m_sleeping = false;
+        }
+        else if (m_sleeping && m_current != m_target) {
+            // Сֵֵûѣֱ
+            m_current = m_target;
+            m_version++;
+        }
     }
 
     // תĳֵû˲Ч
     void setCurrent(const T& newCurrent) {
         m_current = newCurrent;
         m_target = newCurrent; // ͨתĿҲΪֵͬ
+        m_sleeping = true;
+        m_version++;
     }
 
     // ÷ -  setCurrent ͬṩ
     void reset(const T& value = T()) {
-        m_current = value;
-        m_target = value;
+        setCurrent(value);
     }
 
     // ȡǰֵڻƣ
@@ -44,17 +76,29 @@ public:
         return m_target;
     }
 
-    // 鵱ǰֵǷѾǳӽĿֵж϶Ƿ
-    bool isAnimating(float epsilon = 0.001f) const {
-        // ҪʵֱȽϣfloatsf::ColorǿԼ򵥴
-        // ϽʵҪػǰ
-        return true; // 򻯰棬ʼշtrue
+    // ֵǰֵĿֵľСʱΪ
+    void setEpsilon(float epsilon) {
+        m_epsilon = epsilon;
+    }
+
+    // 鶯ǷڽУʱfalse߿ؼ㣩
+    bool isAnimating() const {
+        return !m_sleeping;
+    }
+
+    // ǰֵİ汾ţÿεǰֵıʱ
+    // ֵļֿԻ棬汾Ųʱؽ
+    unsigned int getVersion() const {
+        return m_version;
     }
 
 private:
     T m_current;      // ǰʵֵ
     T m_target;       // Ŀֵ
     float m_smoothFactor; // ƽϵԽԽ죬ͨ5-20֮䣩
+    float m_epsilon;  // ֵ
+    bool m_sleeping;  // Ƿߣ
+    unsigned int m_version; // ǰֵİ汾
 };
 
 //  sf::Color ͵ػ汾ΪColorĲֵҪͨ㣩
@@ -62,11 +106,12 @@ private:
 template <>
 class SmoothValue<sf::Color> {
 public:
-    SmoothValue(const sf::Color& initialValue, float smoothFactor = 8.0f)
-        : m_r(initialValue.r, smoothFactor),
-        m_g(initialValue.g, smoothFactor),
-        m_b(initialValue.b, smoothFactor),
-        m_a(initialValue.a, smoothFactor) {
+    // ÿֵͨĬΪɫףɫĿȫһ
+    SmoothValue(const sf::Color& initialValue, float smoothFactor = 8.0f, float epsilon = 0.5f)
+        : m_r(initialValue.r, smoothFactor, epsilon),
+        m_g(initialValue.g, smoothFactor, epsilon),
+        m_b(initialValue.b, smoothFactor, epsilon),
+        m_a(initialValue.a, smoothFactor, epsilon) {
     }
 
     void update(float dt) {
@@ -92,15 +137,7 @@ public:
 
     //  sf::Color ÷
     void reset(const sf::Color& value = sf::Color::Black) {
-        m_r.setCurrent(value.r);
-        m_g.setCurrent(value.g);
-        m_b.setCurrent(value.b);
-        m_a.setCurrent(value.a);
-
-        m_r.setTarget(value.r);
-        m_g.setTarget(value.g);
-        m_b.setTarget(value.b);
-        m_a.setTarget(value.a);
+        setCurrent(value);
     }
 
     sf::Color getCurrent() const {
@@ -110,6 +147,30 @@ public:
             static_cast<sf::Uint8>(m_a.getCurrent()));
     }
 
+    sf::Color getTarget() const {
+        return sf::Color(static_cast<sf::Uint8>(m_r.getTarget()),
+            static_cast<sf::Uint8>(m_g.getTarget()),
+            static_cast<sf::Uint8>(m_b.getTarget()),
+            static_cast<sf::Uint8>(m_a.getTarget()));
+    }
+
+    void setEpsilon(float epsilon) {
+        m_r.setEpsilon(epsilon);
+        m_g.setEpsilon(epsilon);
+        m_b.setEpsilon(epsilon);
+        m_a.setEpsilon(epsilon);
+    }
+
+    // һͨڱ仯Ϊ
+    bool isAnimating() const {
+        return m_r.isAnimating() || m_g.isAnimating() || m_b.isAnimating() || m_a.isAnimating();
+    }
+
+    // ͨ汾֮ͣͨı䶼ʹ仯
+    unsigned int getVersion() const {
+        return m_r.getVersion() + m_g.getVersion() + m_b.getVersion() + m_a.getVersion();
+    }
+
 private:
     SmoothValue<float> m_r, m_g, m_b, m_a; // ֱR,G,B,Aĸͨ
 }; 
\ No newline at end of file
@@ -2,73 +2,90 @@
 #include <SFML/Graphics.hpp>
 #include <SFML/Audio.hpp>
 #include <iostream>
+#include <cstdio>
 #include <cmath>
 #include <vector>
 #include <algorithm>
 #include "SmoothValue.h"
+#include "QualityGovernor.h"
+#include "LoudnessMeter.h"
+#include "PitchTracker.h"
 
 const int WINDOW_WIDTH = 1200;
 const int WINDOW_HEIGHT = 800;
-const int WAVEFORM_POINTS = 500;  // Number of waveform points
+const int WAVEFORM_POINTS = 500;  // Default number of waveform points
+const float WAVEFORM_THICKNESS = 6.0f;  // Total thickness of the waveform line
 const float WAVEFORM_HEIGHT = 300.0f;  // Waveform display height
-
-// Audio energy calculation function
-float calculateVolume(const sf::Int16* samples, size_t count) {
-    if (count == 0) return 0.0f;
-
-    float sumSquares = 0.0f;
-    for (size_t i = 0; i < count; i++) {
-        float sample = samples[i] / 32768.0f;
-        sumSquares += sample * sample;
-    }
-
-    return std::sqrt(sumSquares / count);
-}
+const float TARGET_LOUDNESS = -14.0f;  // Loudness (LUFS) the visuals are normalized to
 
 // Waveform visualizer class
 class WaveformVisualizer {
 private:
     sf::VertexArray waveform;  // Waveform vertex array
     std::vector<float> audioBuffer;  // Audio buffer
+    std::vector<float> prevValues;  // Previous values for the smoothing filter
     float scaleFactor;  // Waveform scaling factor
+    int pointCount;  // Number of waveform points
+    int thicknessPasses;  // Number of passes used to draw the thick line
 
 public:
     WaveformVisualizer()
-        : waveform(sf::LineStrip, WAVEFORM_POINTS), scaleFactor(100.0f) {
+        : waveform(sf::LineStrip, WAVEFORM_POINTS), scaleFactor(100.0f),
+        pointCount(WAVEFORM_POINTS), thicknessPasses(21) {
+        setPointCount(WAVEFORM_POINTS);
+    }
+
+    // Change the number of waveform points (resets the smoothing filter)
+    void setPointCount(int count) {
+        pointCount = std::max(2, count);
+        waveform.resize(pointCount);
+        prevValues.assign(pointCount, 0.0f);
 
         // Initialize waveform vertices
-        for (int i = 0; i < WAVEFORM_POINTS; i++) {
-            float x = static_cast<float>(i) / (WAVEFORM_POINTS - 1) * WINDOW_WIDTH;
+        for (int i = 0; i < pointCount; i++) {
+            float x = static_cast<float>(i) / (pointCount - 1) * WINDOW_WIDTH;
             waveform[i].position = sf::Vector2f(x, WINDOW_HEIGHT / 2);
             waveform[i].color = sf::Color::White;
         }
     }
 
-    void update(const std::vector<float>& samples, float volume, float time) {
+    void setThicknessPasses(int passes) {
+        thicknessPasses = std::max(1, passes);
+    }
+
+    int getPointCount() const {
+        return pointCount;
+    }
+
+    // volume: linear level from the loudness meter
+    // loudnessGain: normalization gain so every track drives the visuals evenly
+    void update(const std::vector<float>& samples, float volume, float time, float loudnessGain = 1.0f) {
         if (samples.empty()) return;
 
-        // Adjust waveform amplitude based on volume
-        float amplitude = scaleFactor * (5.0f + volume * 15.0f);
+        // Normalize volume to the target loudness
+        volume = std::min(1.0f, volume * loudnessGain);
+
+        // Adjust waveform amplitude based on volume (samples are normalized too)
+        float amplitude = scaleFactor * (5.0f + volume * 15.0f) * loudnessGain;
 
         // Add some dynamic changes based on time
         float timeOffset = sin(time * 2.0f) * 10.0f;
 
         // Update waveform
-        for (int i = 0; i < WAVEFORM_POINTS; i++) {
+        for (int i = 0; i < pointCount; i++) {
             // Calculate sample index (uniform sampling)
-            int sampleIndex = (i * samples.size()) / WAVEFORM_POINTS;
+            int sampleIndex = (i * samples.size()) / pointCount;
             sampleIndex = std::min(sampleIndex, (int)samples.size() - 1);
 
             // Get sample value
             float sampleValue = samples[sampleIndex];
 
             // Apply smoothing filter
-            static std::vector<float> prevValues(WAVEFORM_POINTS, 0.0f);
             float smoothedValue = prevValues[i] * 0.7f + sampleValue * 0.3f;
             prevValues[i] = smoothedValue;
 
             // Calculate y coordinate (centered)
-            float x = static_cast<float>(i) / (WAVEFORM_POINTS - 1) * WINDOW_WIDTH;
+            float x = static_cast<float>(i) / (pointCount - 1) * WINDOW_WIDTH;
             float y = WINDOW_HEIGHT / 2 + smoothedValue * amplitude;
 
             // Add time offset to make waveform dynamic
@@ -99,10 +116,14 @@ public:
     }
 
     void draw(sf::RenderTarget& target) {
-        for (int offset = -10; offset <= 10; offset++) {
-            sf::VertexArray thickLine = waveform;
+        // Draw the line several times with a small offset to make it thick;
+        // fewer passes keep the same total thickness with wider spacing
+        int halfPasses = thicknessPasses / 2;
+        float spacing = halfPasses > 0 ? WAVEFORM_THICKNESS / (2 * halfPasses) : 0.0f;
+        sf::VertexArray thickLine = waveform;
+        for (int offset = -halfPasses; offset <= halfPasses; offset++) {
             for (unsigned int i = 0; i < thickLine.getVertexCount(); i++) {
-                thickLine[i].position.y += static_cast<float>(offset) * 0.3f;
+                thickLine[i].position.y = waveform[i].position.y + static_cast<float>(offset) * spacing;
             }
             target.draw(thickLine);
         }
@@ -188,15 +209,66 @@ int main() {
     // 6. Time management
     sf::Clock frameClock;
     sf::Clock audioClock;
+    sf::Clock workClock;  // Measures frame work time (excluding frame limiter wait)
     bool isPlaying = false;
     int frameCount = 0;
 
     // 7. Smooth volume
     SmoothValue<float> smoothedVolume(0.0f, 10.0f);
 
-    // 8. Add particle system as background (optional)
+    // Loudness meter (EBU R128) and pitch tracker, fed with every sample up to the playback position
+    LoudnessMeter loudnessMeter(sampleRate, channels);
+    PitchTracker pitchTracker(sampleRate, channels);
+    size_t analyzedFrames = 0;
+    SmoothValue<float> smoothedGain(1.0f, 2.0f);
+
+    // Timeline; MELODY_HIGHLIGHT is fired by the pitch tracker when the motif is heard
+    MusicTimeline timeline = MusicTimeline::createDvorakTimeline();
+    SmoothValue<float> melodyFlash(0.0f, 3.0f);
+    timeline.setCallback(VisualEventType::MELODY_HIGHLIGHT, [&](const TimelineEvent&) {
+        melodyFlash.setCurrent(1.0f);
+        melodyFlash.setTarget(0.0f);
+    });
+    pitchTracker.addPattern(MelodyPattern("mi-fa-so-fa-mi", { 1, 2, -2, -1 }));
+    pitchTracker.setPatternCallback([&](const TimelineEvent& melodyEvent) {
+        timeline.fireEvent(melodyEvent);
+    });
+
+    // Epic explosion effect, driven by the timeline's enter/exit notifications.
+    // The event is copied on enter, and its progress is derived from the timeline
+    // time, so seeking into the middle of the explosion shows it at the right stage.
+    bool explosionActive = false;
+    TimelineEvent explosionEvent(0.0f, VisualEventType::EPIC_EXPLOSION);
+    timeline.setEnterCallback(VisualEventType::EPIC_EXPLOSION, [&](const TimelineEvent& epicEvent, float) {
+        explosionActive = true;
+        explosionEvent = epicEvent;
+    });
+    timeline.setExitCallback(VisualEventType::EPIC_EXPLOSION, [&](const TimelineEvent&) {
+        explosionActive = false;
+    });
+
+    // Deep gold color shift, handled the same way
+    bool colorShiftActive = false;
+    TimelineEvent colorShiftEvent(0.0f, VisualEventType::COLOR_CHANGE);
+    timeline.setEnterCallback(VisualEventType::COLOR_CHANGE, [&](const TimelineEvent& colorEvent, float) {
+        colorShiftActive = true;
+        colorShiftEvent = colorEvent;
+    });
+    timeline.setExitCallback(VisualEventType::COLOR_CHANGE, [&](const TimelineEvent&) {
+        colorShiftActive = false;
+    });
+    timeline.play();
+
+    // 8. Adaptive quality governor
+    const float TARGET_FPS_OPTIONS[] = { 60.0f, 144.0f };
+    int targetFpsIndex = 0;
+    QualityGovernor governor(TARGET_FPS_OPTIONS[targetFpsIndex]);
+    int appliedTier = -1;
+
+    // 9. Add particle system as background (optional)
+    // Created for the highest tier, only the first particleCount are drawn
     std::vector<sf::CircleShape> backgroundParticles;
-    for (int i = 0; i < 100; i++) {
+    for (int i = 0; i < QUALITY_TIERS[QUALITY_TIER_COUNT - 1].particleCount; i++) {
         sf::CircleShape particle(1.0f + (rand() % 100) / 100.0f * 3.0f);
         particle.setPosition(
             rand() % WINDOW_WIDTH,
@@ -214,15 +286,84 @@ int main() {
     std::cout << "  + - Increase waveform amplitude" << std::endl;
     std::cout << "  - - Decrease waveform amplitude" << std::endl;
     std::cout << "  C - Toggle color mode" << std::endl;
+    std::cout << "  T - Toggle target FPS (60/144)" << std::endl;
+    std::cout << "  Q - Toggle automatic quality" << std::endl;
+    std::cout << "  [ / ] - Lower/raise quality tier (fixed quality)" << std::endl;
 
     float currentScale = 100.0f;
     bool colorMode = true;  // true: Colorful, false: Monochromatic
 
+    // 10. UI text (font and static text are created once, not every frame)
+    sf::Font font;
+    bool fontLoaded = font.loadFromFile("C:/Windows/Fonts/arial.ttf");
+
+    sf::Text infoText;
+    infoText.setFont(font);
+    infoText.setCharacterSize(20);
+    infoText.setFillColor(sf::Color::White);
+    infoText.setPosition(20, 20);
+    std::string lastInfoKey;  // Settings the info text was last built from
+
+    // Playback values; rebuilt only while playing or while the smoothed volume moves
+    sf::Text playbackText;
+    playbackText.setFont(font);
+    playbackText.setCharacterSize(20);
+    playbackText.setFillColor(sf::Color::White);
+    playbackText.setPosition(20, 20);
+    std::string volumeText;
+    unsigned int volumeTextVersion = smoothedVolume.getVersion() - 1;  // Force first build
+    bool playbackTextValid = false;
+
+    // Frame statistics, refreshed twice per second
+    sf::Text statsText;
+    statsText.setFont(font);
+    statsText.setCharacterSize(18);
+    statsText.setFillColor(sf::Color(200, 200, 200));
+    statsText.setPosition(WINDOW_WIDTH - 300, WINDOW_HEIGHT - 60);
+    sf::Clock statsClock;
+    const float STATS_REFRESH_INTERVAL = 0.5f;
+
+    // Control instructions
+    sf::Text controlsText;
+    controlsText.setFont(font);
+    controlsText.setCharacterSize(18);
+    controlsText.setFillColor(sf::Color(200, 200, 200));
+    controlsText.setPosition(WINDOW_WIDTH - 300, 20);
+
+    std::string controls = "Controls:\n";
+    controls += "SPACE: Play/Pause\n";
+    controls += "R: Restart\n";
+    controls += "+/-: Adjust waveform amplitude\n";
+    controls += "C: Toggle color mode\n";
+    controls += "T: Toggle target FPS\n";
+    controls += "Q: Toggle auto quality\n";
+    controls += "[/]: Quality tier (fixed)\n";
+    controls += "ESC: Exit";
+    controlsText.setString(controls);
+
+    // Waveform description
+    sf::Text waveText;
+    waveText.setFont(font);
+    waveText.setCharacterSize(24);
+    waveText.setFillColor(sf::Color(150, 200, 255));
+    waveText.setPosition(WINDOW_WIDTH / 2 - 150, WINDOW_HEIGHT - 100);
+
     // Main loop
     while (window.isOpen()) {
         float dt = frameClock.restart().asSeconds();
+        workClock.restart();
         frameCount++;
 
+        // Apply quality levers when the tier changes
+        if (governor.getTier() != appliedTier) {
+            appliedTier = governor.getTier();
+            const QualitySettings& quality = governor.getSettings();
+            waveform.setPointCount(quality.waveformPoints);
+            waveform.setThicknessPasses(quality.thicknessPasses);
+            std::cout << "Quality tier: " << quality.name << std::endl;
+        }
+        const QualitySettings& quality = governor.getSettings();
+
         // Event handling
         sf::Event event;
         while (window.pollEvent(event)) {
@@ -258,6 +399,10 @@ int main() {
                         sound.play();
                         isPlaying = true;
                         audioClock.restart();
+                        loudnessMeter.reset();
+                        pitchTracker.reset();
+                        timeline.reset();
+                        analyzedFrames = 0;
                         std::cout << "Restarted playback" << std::endl;
                     }
                     else {
@@ -282,6 +427,26 @@ int main() {
                     colorMode = !colorMode;
                     std::cout << "Color mode: " << (colorMode ? "Colorful" : "Monochromatic") << std::endl;
                 }
+
+                if (event.key.code == sf::Keyboard::T) {
+                    targetFpsIndex = (targetFpsIndex + 1) % 2;
+                    governor.setTargetFps(TARGET_FPS_OPTIONS[targetFpsIndex]);
+                    window.setFramerateLimit(static_cast<unsigned int>(governor.getTargetFps()));
+                    std::cout << "Target FPS: " << governor.getTargetFps() << std::endl;
+                }
+
+                if (event.key.code == sf::Keyboard::Q) {
+                    governor.setEnabled(!governor.isEnabled());
+                    std::cout << "Automatic quality: " << (governor.isEnabled() ? "On" : "Off") << std::endl;
+                }
+
+                if (!governor.isEnabled() && event.key.code == sf::Keyboard::LBracket) {
+                    governor.setTier(governor.getTier() - 1);
+                }
+
+                if (!governor.isEnabled() && event.key.code == sf::Keyboard::RBracket) {
+                    governor.setTier(governor.getTier() + 1);
+                }
             }
         }
 
@@ -289,7 +454,8 @@ int main() {
         window.clear(sf::Color(10, 10, 30));
 
         // Draw background particles
-        for (auto& particle : backgroundParticles) {
+        for (int i = 0; i < quality.particleCount; i++) {
+            sf::CircleShape& particle = backgroundParticles[i];
             // Move particles slowly
             particle.move(0.1f, 0.05f);
 
@@ -307,8 +473,20 @@ int main() {
         // Get audio data and time
         float currentTime = 0.0f;
         float currentVolume = 0.0f;
+        float loudnessGain = 1.0f;
         std::vector<float> currentSamples;
 
+        // The track finished: sf::Sound stops and reports offset 0, which must not be
+        // read as a jump back to the start (that would discard the completed measurements)
+        if (hasAudio && isPlaying && sound.getStatus() == sf::Sound::Stopped) {
+            size_t endFrames = totalSamples / channels;
+            loudnessMeter.process(&allSamples[analyzedFrames * channels], endFrames - analyzedFrames);
+            pitchTracker.process(&allSamples[analyzedFrames * channels], endFrames - analyzedFrames);
+            analyzedFrames = endFrames;
+            isPlaying = false;
+            std::cout << "Playback finished" << std::endl;
+        }
+
         if (hasAudio && isPlaying) {
             // Get current playback time
             currentTime = sound.getPlayingOffset().asSeconds();
@@ -318,20 +496,32 @@ int main() {
                 currentTime * sampleRate * channels
                 );
 
+            // Feed every frame played since the last update to the analyzers
+            size_t playedFrames = std::min(
+                static_cast<size_t>(currentTime * sampleRate), totalSamples / channels);
+            if (playedFrames < analyzedFrames) {
+                // Playback jumped backwards
+                loudnessMeter.reset();
+                pitchTracker.reset();
+                analyzedFrames = 0;
+            }
+            loudnessMeter.process(&allSamples[analyzedFrames * channels], playedFrames - analyzedFrames);
+            pitchTracker.process(&allSamples[analyzedFrames * channels], playedFrames - analyzedFrames);
+            analyzedFrames = playedFrames;
+            timeline.update(currentTime);  // Also handles backward jumps as a seek
+
+            // Current volume from momentary loudness, gain from program loudness
+            currentVolume = loudnessMeter.loudnessToAmplitude(loudnessMeter.getMomentaryLoudness());
+            loudnessGain = loudnessMeter.getNormalizationGain(TARGET_LOUDNESS);
+
             // Analysis window size
-            const size_t ANALYSIS_SIZE = 4096;
+            const size_t ANALYSIS_SIZE = quality.analysisSize;
 
             if (sampleIndex + ANALYSIS_SIZE < totalSamples) {
-                // Calculate current volume
-                currentVolume = calculateVolume(
-                    &allSamples[sampleIndex],
-                    std::min(ANALYSIS_SIZE, totalSamples - sampleIndex)
-                );
-
                 // Extract sample data for waveform display
                 currentSamples.resize(ANALYSIS_SIZE);
                 for (size_t i = 0; i < ANALYSIS_SIZE; i++) {
-                    if (sampleIndex + i < totalSamples) {
+                    if (sampleIndex + (i + 1) * channels <= totalSamples) {
                         // If stereo, take average
                         if (channels == 2) {
                             float left = allSamples[sampleIndex + i * 2] / 32768.0f;
@@ -353,7 +543,7 @@ int main() {
             currentTime = audioClock.getElapsedTime().asSeconds();
 
             // Generate simulated audio data
-            currentSamples.resize(4096);
+            currentSamples.resize(quality.analysisSize);
             float baseFrequency = 220.0f;  // A3 note
             float melodyFrequency = 440.0f;  // A4 note
 
@@ -381,18 +571,62 @@ int main() {
             currentVolume = 0.5f + 0.3f * sin(currentTime * 0.5f);
         }
 
-        // Smooth volume
+        // Smooth volume (sleeps once converged, woken again by setTarget)
         smoothedVolume.setTarget(currentVolume);
         smoothedVolume.update(dt);
+        smoothedGain.setTarget(loudnessGain);
+        smoothedGain.update(dt);
+        melodyFlash.update(dt);
 
         // Update waveform visualizer
         if (!currentSamples.empty()) {
-            waveform.update(currentSamples, smoothedVolume.getCurrent(), currentTime);
+            waveform.update(currentSamples, smoothedVolume.getCurrent(), currentTime, smoothedGain.getCurrent());
         }
 
         // Draw waveform
         waveform.draw(window);
 
+        // Deep gold tint, fading in over the first seconds of the color shift
+        if (colorShiftActive) {
+            float elapsed = timeline.getCurrentTime() - colorShiftEvent.time;
+            float fade = std::max(0.001f, colorShiftEvent.getParam("fade", 1.0f));
+            float strength = std::clamp(elapsed / fade, 0.0f, 1.0f);
+            sf::RectangleShape tint(sf::Vector2f(WINDOW_WIDTH, WINDOW_HEIGHT));
+            tint.setFillColor(sf::Color(200, 140, 20, static_cast<sf::Uint8>(strength * 50)));
+            window.draw(tint);
+        }
+
+        // Epic explosion glow, fading out over the event's duration
+        if (explosionActive) {
+            float progress = explosionEvent.getProgress(timeline.getCurrentTime());
+            float intensity = explosionEvent.getParam("intensity", 1.0f) * (1.0f - progress);
+            sf::RectangleShape glow(sf::Vector2f(WINDOW_WIDTH, WINDOW_HEIGHT));
+            glow.setFillColor(sf::Color(255, 180, 60, static_cast<sf::Uint8>(intensity * 80)));
+            window.draw(glow);
+        }
+
+        // Melody highlight: warm flash over the waveform area
+        if (melodyFlash.isAnimating()) {
+            sf::RectangleShape flash(sf::Vector2f(WINDOW_WIDTH, WAVEFORM_HEIGHT));
+            flash.setPosition(0, WINDOW_HEIGHT / 2 - WAVEFORM_HEIGHT / 2);
+            flash.setFillColor(sf::Color(255, 200, 80, static_cast<sf::Uint8>(melodyFlash.getCurrent() * 60)));
+            window.draw(flash);
+        }
+
+        // Chroma bars (one per pitch class) along the bottom edge
+        if (hasAudio) {
+            const PitchFrame& pitch = pitchTracker.getLatestFrame();
+            const float barWidth = 20.0f;
+            for (int i = 0; i < 12; i++) {
+                float height = pitch.chroma[i] * 60.0f;
+                sf::RectangleShape bar(sf::Vector2f(barWidth - 4.0f, height));
+                bar.setPosition(20 + i * barWidth, WINDOW_HEIGHT - 20 - height);
+                bool isCurrentNote = pitch.midiNote >= 0 && pitch.midiNote % 12 == i;
+                bar.setFillColor(isCurrentNote ? sf::Color(255, 200, 80, 200) : sf::Color(150, 200, 255, 120));
+                window.draw(bar);
+            }
+        }
+
         // Draw center reference line
         sf::RectangleShape centerLine(sf::Vector2f(WINDOW_WIDTH, 1));
         centerLine.setPosition(0, WINDOW_HEIGHT / 2);
@@ -400,52 +634,71 @@ int main() {
         window.draw(centerLine);
 
         // Draw UI information
-        sf::Font font;
-        if (font.loadFromFile("C:/Windows/Fonts/arial.ttf")) {
-            sf::Text infoText;
-            infoText.setFont(font);
-            infoText.setCharacterSize(20);
-            infoText.setFillColor(sf::Color::White);
-            infoText.setPosition(20, 20);
-
-            std::string info = "Waveform Visualizer Demo\n";
-            info += hasAudio ? "Audio file: Loaded" : "Audio file: Simulated data";
-            info += "\nStatus: " + std::string(isPlaying ? "Playing" : "Paused");
-            info += "\nVolume: " + std::to_string(smoothedVolume.getCurrent());
-            info += "\nTime: " + std::to_string(currentTime) + "s";
-            info += "\nWaveform points: " + std::to_string(WAVEFORM_POINTS);
-            info += "\nWaveform amplitude: " + std::to_string(currentScale);
-            info += "\nColor mode: " + std::string(colorMode ? "Colorful" : "Monochromatic");
-
-            infoText.setString(info);
-            window.draw(infoText);
+        if (fontLoaded) {
+            // Settings part: only changes on key presses or tier changes
+            char infoKey[64];
+            snprintf(infoKey, sizeof(infoKey), "%d %d %.0f %d %d %d %.0f", isPlaying, waveform.getPointCount(),
+                currentScale, colorMode, governor.getTier(), governor.isEnabled(), governor.getTargetFps());
+            if (lastInfoKey != infoKey) {
+                lastInfoKey = infoKey;
+
+                std::string info = "Waveform Visualizer Demo\n";
+                info += hasAudio ? "Audio file: Loaded" : "Audio file: Simulated data";
+                info += "\nStatus: " + std::string(isPlaying ? "Playing" : "Paused");
+                info += "\nWaveform points: " + std::to_string(waveform.getPointCount());
+                info += "\nWaveform amplitude: " + std::to_string(currentScale);
+                info += "\nColor mode: " + std::string(colorMode ? "Colorful" : "Monochromatic");
+                info += "\n" + governor.getStatusText();
+
+                infoText.setString(info);
+                sf::FloatRect bounds = infoText.getLocalBounds();
+                playbackText.setPosition(20, 20 + bounds.top + bounds.height + 10);
+            }
+
+            // Playback part: rebuilt while playing, or while the smoothed volume
+            // is still settling after a pause; a settled, paused scene keeps the cached text
+            bool volumeMoved = smoothedVolume.getVersion() != volumeTextVersion;
+            if (isPlaying || volumeMoved || !playbackTextValid) {
+                if (volumeMoved) {
+                    volumeTextVersion = smoothedVolume.getVersion();
+                    volumeText = std::to_string(smoothedVolume.getCurrent());
+                }
+
+                std::string playback = "Volume: " + volumeText;
+                playback += "\nTime: " + std::to_string(currentTime) + "s";
+                if (hasAudio) {
+                    playback += "\nLoudness M/S/I: " + std::to_string(loudnessMeter.getMomentaryLoudness());
+                    playback += " / " + std::to_string(loudnessMeter.getShortTermLoudness());
+                    playback += " / " + std::to_string(loudnessMeter.getIntegratedLoudness()) + " LUFS";
+                    playback += "\nTrue peak: " + std::to_string(loudnessMeter.getTruePeak()) + " dBTP";
+                    const PitchFrame& pitch = pitchTracker.getLatestFrame();
+                    playback += "\nPitch: " + PitchTracker::noteName(pitch.midiNote);
+                    if (pitch.midiNote >= 0) playback += " (" + std::to_string(pitch.frequency) + " Hz)";
+                    playback += "\nActive effects: " + std::to_string(timeline.getActiveEvents().size());
+                }
+                playbackText.setString(playback);
+                playbackTextValid = true;
+            }
+
+            // Frame statistics are throttled so they do not rebuild text every frame
+            if (statsClock.getElapsedTime().asSeconds() >= STATS_REFRESH_INTERVAL) {
+                statsClock.restart();
+                statsText.setString(governor.getFrameStatsText());
+            }
 
-            // Draw control instructions
-            sf::Text controlsText;
-            controlsText.setFont(font);
-            controlsText.setCharacterSize(18);
-            controlsText.setFillColor(sf::Color(200, 200, 200));
-            controlsText.setPosition(WINDOW_WIDTH - 300, 20);
-
-            std::string controls = "Controls:\n";
-            controls += "SPACE: Play/Pause\n";
-            controls += "R: Restart\n";
-            controls += "+/-: Adjust waveform amplitude\n";
-            controls += "C: Toggle color mode\n";
-            controls += "ESC: Exit";
-
-            controlsText.setString(controls);
+            window.draw(infoText);
+            window.draw(playbackText);
+            window.draw(statsText);
             window.draw(controlsText);
         }
 
         // Draw waveform description
-        sf::Text waveText;
-        waveText.setFont(font);
-        waveText.setCharacterSize(24);
-        waveText.setFillColor(sf::Color(150, 200, 255));
-        waveText.setPosition(WINDOW_WIDTH / 2 - 150, WINDOW_HEIGHT - 100);
         window.draw(waveText);
 
+        // Feed the work time (measured before the frame limiter waits) and the
+        // real interval of the last frame, which includes display() and swap
+        governor.addFrameTime(workClock.getElapsedTime().asSeconds(), dt);
+
         // Display final frame
         window.display();
     }